@@ -1,8 +1,13 @@
 #pragma once 
 #include <string>
+#include <fstream>
+#include <iterator>
 #include <openssl/sha.h>
 #include <chrono>
 #include <array>
+#include <vector>
+#include <unordered_set>
+#include "ObjectPack.hpp"
 using namespace std;
 class Blob {
 private: 
@@ -30,11 +35,29 @@ static string hash(const string& content) {
   hex[i*2+1] = hexdigits[digest[i] & 0x0F]; 
  }              
  return hex;    } 
-// Loads blob content from object database 
+// Loads blob content from loose objects or packs (fetched lazily in blobless clones)
 static string load(const string& hash) {  
-ifstream file(".minigit/objects/" + hash, ios::binary);    
- return {istreambuf_iterator<char>(file), 
-  istreambuf_iterator<char>()};
- 
+ string content;
+ if (!ObjectPack::readObject(".minigit/objects", hash, content) && !prefetch({hash}).empty()) {
+  ObjectPack::readObject(".minigit/objects", hash, content);
+ }
+ return content;
+}
+// Fetches missing blobs from the promisor remote in one pack, returns fetched hashes
+static vector<string> prefetch(const vector<string>& hashes) {
+ string remote = ObjectPack::promisorRemote();
+ if (remote.empty()) return {};
+ vector<string> missing;
+ unordered_set<string> seen;
+ for (const auto& h : hashes) {
+  if (seen.insert(h).second && !ObjectPack::hasObject(".minigit/objects", h)) missing.push_back(h);
+ }
+ return ObjectPack::transfer(remote, ".", missing);
+}
+// Stores content in object database and returns its hash
+static string save(const string& content) {
+ string blobHash = hash(content);
+ ObjectPack::writeLoose(".minigit/objects", blobHash, content);
+ return blobHash;
 }
 };
@@ -10,45 +10,98 @@
 using namespace std;
 
 class BranchMap {
-private:
-    unordered_map<string, string> branches;
-    string currentBranch = "main";
-
+public:
     struct MergeResult {
         unordered_map<string, string> files;
         vector<string> conflicts;
     };
 
+private:
+    unordered_map<string, string> branches;
+    string currentBranch = "main";
+
     MergeResult threeWayMerge(
         const string& ourHash,
         const string& theirHash,
         const string& baseHash
     ) {
-        MergeResult result;
         Commit ourCommit = Commit::load(ourHash);
         Commit theirCommit = Commit::load(theirHash);
         Commit baseCommit = baseHash.empty() ? Commit("", "", {}) : Commit::load(baseHash);
 
-        // Collect all unique files from all three commits
+        // Fetch blobs missing from a blobless clone in one batch
+        vector<string> blobHashes;
+        for (const Commit* commit : {&ourCommit, &theirCommit, &baseCommit}) {
+            for (const auto& [_, hash] : commit->getBlobs()) blobHashes.push_back(hash);
+        }
+        Blob::prefetch(blobHashes);
+
+        // Resolve blob hashes to file contents
+        auto loadContents = [](const Commit& commit) {
+            unordered_map<string, string> contents;
+            for (const auto& [file, hash] : commit.getBlobs()) {
+                contents[file] = Blob::load(hash);
+            }
+            return contents;
+        };
+
+        return mergeContents(loadContents(ourCommit),
+                             loadContents(theirCommit),
+                             loadContents(baseCommit));
+    }
+
+    static bool hasOverlappingChanges(const vector<string>& diff1, const vector<string>& diff2) {
+        // Simplified check - in real implementation would analyze line ranges
+        return !diff1.empty() && !diff2.empty();
+    }
+
+    static string mergeChanges(const string& base, const vector<string>& diff1, const vector<string>& diff2) {
+        // Simple concatenation merge - would be enhanced with proper line-based merging
+        string merged = base;
+        for (const auto& line : diff1) {
+            if (line[0] == '+') merged += "\n" + line.substr(2);
+        }
+        for (const auto& line : diff2) {
+            if (line[0] == '+') merged += "\n" + line.substr(2);
+        }
+        return merged;
+    }
+
+    static string generateConflictMarkers(const string& ours, const string& theirs, const string& base) {
+        return "<<<<<<< OURS\n" + ours + 
+               "\n=======\n" + theirs + 
+               "\n>>>>>>> THEIRS\n";
+    }
+
+public:
+    // Merges file contents (filename -> content) of two trees against their base
+    static MergeResult mergeContents(
+        const unordered_map<string, string>& ours,
+        const unordered_map<string, string>& theirs,
+        const unordered_map<string, string>& base
+    ) {
+        MergeResult result;
+
+        // Collect all unique files from all three trees
         unordered_set<string> allFiles;
-        auto collectFiles = [&](const Commit& commit) {
-            for (const auto& [file, _] : commit.getBlobs()) {
+        auto collectFiles = [&](const unordered_map<string, string>& tree) {
+            for (const auto& [file, _] : tree) {
                 allFiles.insert(file);
             }
         };
-        collectFiles(ourCommit);
-        collectFiles(theirCommit);
-        collectFiles(baseCommit);
+        collectFiles(ours);
+        collectFiles(theirs);
+        collectFiles(base);
 
         // Process each file
         for (const auto& file : allFiles) {
-            bool inOurs = ourCommit.getBlobs().count(file);
-            bool inTheirs = theirCommit.getBlobs().count(file);
-            bool inBase = baseCommit.getBlobs().count(file);
+            bool inOurs = ours.count(file);
+            bool inTheirs = theirs.count(file);
+            bool inBase = base.count(file);
 
-            string ourContent = inOurs ? Blob::load(ourCommit.getBlobs().at(file)) : "";
-            string theirContent = inTheirs ? Blob::load(theirCommit.getBlobs().at(file)) : "";
-            string baseContent = inBase ? Blob::load(baseCommit.getBlobs().at(file)) : "";
+            string ourContent = inOurs ? ours.at(file) : "";
+            string theirContent = inTheirs ? theirs.at(file) : "";
+            string baseContent = inBase ? base.at(file) : "";
 
             // Case 1: Added in theirs only
             if (!inOurs && inTheirs && !inBase) {
@@ -58,14 +111,30 @@ private:
             else if (inOurs && !inTheirs && !inBase) {
                 result.files[file] = ourContent;
             }
-            // Case 3: Modified in both.
+            // Case 3: Deleted on one side; a modification on the other conflicts
+            else if (inBase && inOurs != inTheirs) {
+                const string& kept = inOurs ? ourContent : theirContent;
+                if (kept != baseContent) {
+                    result.files[file] = generateConflictMarkers(ourContent, theirContent, baseContent);
+                    result.conflicts.push_back(file);
+                    Logger::error("CONFLICT: Modify/delete conflict in " + file);
+                }
+            }
+            // Case 4: Modified in both.
             else if (inOurs && inTheirs) {
                 if (ourContent == theirContent) {
                     result.files[file] = ourContent;
                 }
+                // Only one side changed: take that side
+                else if (inBase && ourContent == baseContent) {
+                    result.files[file] = theirContent;
+                }
+                else if (inBase && theirContent == baseContent) {
+                    result.files[file] = ourContent;
+                }
                 else {
                     string conflictContent;
-                    if (inBase && ourContent != baseContent && theirContent != baseContent) {
+                    if (inBase) {
                         // Real three-way merge
                         auto diffOurs = Diff::compare(baseContent, ourContent);
                         auto diffTheirs = Diff::compare(baseContent, theirContent);
@@ -93,30 +162,6 @@ private:
         return result;
     }
 
-    bool hasOverlappingChanges(const vector<string>& diff1, const vector<string>& diff2) {
-        // Simplified check - in real implementation would analyze line ranges
-        return !diff1.empty() && !diff2.empty();
-    }
-
-    string mergeChanges(const string& base, const vector<string>& diff1, const vector<string>& diff2) {
-        // Simple concatenation merge - would be enhanced with proper line-based merging
-        string merged = base;
-        for (const auto& line : diff1) {
-            if (line[0] == '+') merged += "\n" + line.substr(2);
-        }
-        for (const auto& line : diff2) {
-            if (line[0] == '+') merged += "\n" + line.substr(2);
-        }
-        return merged;
-    }
-
-    string generateConflictMarkers(const string& ours, const string& theirs, const string& base) {
-        return "<<<<<<< OURS\n" + ours + 
-               "\n=======\n" + theirs + 
-               "\n>>>>>>> THEIRS\n";
-    }
-
-public:
     // ..(existing branch management methods remain the same) ...
 
     string merge(const string& branchName, bool autoResolve = false) {
@@ -144,7 +189,7 @@ public:
         }
 
         string mergeMsg = "Merge branch '" + branchName + "' into " + currentBranch;
-        Commit mergeCommit = Commit::createMergeCommit(result.files, ourCommit, theirCommit);
+        Commit mergeCommit = Commit::createMergeCommit(result.files, ourCommit, theirCommit, mergeMsg);
         branches[currentBranch] = mergeCommit.getHash();
         
         return mergeCommit.getHash();
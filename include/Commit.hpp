@@ -1,6 +1,13 @@
 #pragma once
 #include <string>
+#include <map>
 #include <unordered_map>
+#include <unordered_set>
+#include <istream>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+#include <ostream>
 #include <ctime>
 #include <fstream>
 #include "Blob.hpp"
@@ -10,6 +17,7 @@ class Commit {
 private:
     string commitHash;
     string parentHash;
+    string mergeParentHash; // second parent of merge commits
     string message;
     time_t timestamp;
     unordered_map<string, string> blobs; // filename -> blob hash
@@ -20,18 +28,20 @@ private:
         return cache;
     }
 
-public:
-    // Creates new commit with staged files and parent reference
-    Commit(const string& msg, const string& parent, 
-           const unordered_map<string, string>& stagedBlobs)
-        : message(msg), parentHash(parent), timestamp(time(nullptr)) 
+    // Builds a commit with an explicit timestamp (parsed objects keep theirs)
+    Commit(const string& msg, const string& parent,
+           const unordered_map<string, string>& stagedBlobs,
+           const string& mergeParent, time_t time)
+        : parentHash(parent), mergeParentHash(mergeParent), message(msg), timestamp(time)
     {
         string commitData;
-        commitData.reserve(message.size() + parentHash.size() + 20);
-        commitData.append(message).append(parentHash)
+        commitData.reserve(message.size() + parentHash.size() + mergeParentHash.size() + 20);
+        commitData.append(message).append(parentHash).append(mergeParentHash)
                  .append(to_string(timestamp));
         
-        for (const auto& [file, hash] : stagedBlobs) {
+        // Sorted so equal contents hash alike regardless of map insertion order
+        map<string, string> ordered(stagedBlobs.begin(), stagedBlobs.end());
+        for (const auto& [file, hash] : ordered) {
             commitData.append(file).append(hash);
         }
         
@@ -39,6 +49,13 @@ public:
         blobs = stagedBlobs;
     }
 
+public:
+    // Creates new commit with staged files and parent reference(s)
+    Commit(const string& msg, const string& parent, 
+           const unordered_map<string, string>& stagedBlobs,
+           const string& mergeParent = "")
+        : Commit(msg, parent, stagedBlobs, mergeParent, time(nullptr)) {}
+
     // Loads commit from object database (cached)
     static Commit load(const string& hash) {
         auto& cache = getCache();
@@ -46,39 +63,84 @@ public:
             return it->second;
         }
 
-        ifstream file(".minigit/objects/" + hash);
-        if (!file) throw runtime_error("Commit not found");
-        
+        string data;
+        if (!ObjectPack::readObject(".minigit/objects", hash, data)) {
+            throw runtime_error("Commit not found");
+        }
+
+        istringstream file(data);
+        Commit loaded = parse(file);
+        loaded.commitHash = hash; // object name is the commit's identity
+        cache.emplace(hash, loaded);
+        return loaded;
+    }
+
+    // Parses commit object format (no filesystem access)
+    static Commit parse(istream& in) {
         // Parse metadata line: parentHash|timestamp|message
         string metaLine;
-        getline(file, metaLine);
+        getline(in, metaLine);
         size_t sep1 = metaLine.find('|');
         size_t sep2 = metaLine.rfind('|');
+
+        // Timestamp sits between the separators; missing or malformed reads as 0
+        time_t stamp = 0;
+        if (sep1 != string::npos && sep2 > sep1) {
+            string field = metaLine.substr(sep1 + 1, sep2 - sep1 - 1);
+            char* end = nullptr;
+            errno = 0;
+            long long value = strtoll(field.c_str(), &end, 10);
+            if (!field.empty() && end == field.c_str() + field.size() && errno == 0) stamp = static_cast<time_t>(value);
+        }
         
-        // Parse file entries: filename|blobHash
+        // Parse file entries: filename|blobHash, and "parent2 <hash>" for merges
         unordered_map<string, string> loadedBlobs;
+        string mergeParent;
         string line;
-        while (getline(file, line)) {
+        while (getline(in, line)) {
             size_t sep = line.find('|');
             if (sep != string::npos) {
                 loadedBlobs[line.substr(0, sep)] = line.substr(sep + 1);
+            } else if (line.rfind("parent2 ", 0) == 0) {
+                mergeParent = line.substr(8);
             }
         }
 
-        Commit loaded(metaLine.substr(sep2 + 1), 
-                     metaLine.substr(0, sep1), 
-                     loadedBlobs);
-        cache[hash] = loaded;
-        return loaded;
+        return Commit(metaLine.substr(sep2 + 1), 
+                      metaLine.substr(0, sep1), 
+                      loadedBlobs,
+                      mergeParent,
+                      stamp);
     }
 
     // Writes commit data to object database
     void save() const {
-        ofstream file(".minigit/objects/" + commitHash);
-        file << parentHash << "|" << timestamp << "|" << message << "\n";
-        for (const auto& [file, hash] : blobs) {
-            file << file << "|" << hash << "\n";
+        ostringstream data;
+        write(data);
+        ObjectPack::writeLoose(".minigit/objects", commitHash, data.str());
+    }
+
+    // Serializes commit in the format read by parse()
+    void write(ostream& out) const {
+        out << parentHash << "|" << timestamp << "|" << message << "\n";
+        if (!mergeParentHash.empty()) out << "parent2 " << mergeParentHash << "\n";
+        for (const auto& [name, hash] : blobs) {
+            out << name << "|" << hash << "\n";
+        }
+    }
+
+    // Stores merged file contents and commits them on top of ours
+    static Commit createMergeCommit(const unordered_map<string, string>& files,
+                                    const string& ourParent,
+                                    const string& theirParent,
+                                    const string& msg = "Merge") {
+        unordered_map<string, string> mergedBlobs;
+        for (const auto& [name, content] : files) {
+            mergedBlobs[name] = Blob::save(content);
         }
+        Commit merged(msg, ourParent, mergedBlobs, theirParent);
+        merged.save();
+        return merged;
     }
 
     // Finds lowest common ancestor of two commits
@@ -101,6 +163,7 @@ public:
     // Accessors
     string getHash() const { return commitHash; }
     string getParent() const { return parentHash; }
+    string getMergeParent() const { return mergeParentHash; }
     const unordered_map<string, string>& getBlobs() const { return blobs; }
     time_t getTimestamp() const { return timestamp; }
     string getMessage() const { return message; }
@@ -0,0 +1,555 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include "Blob.hpp"
+#include "Commit.hpp"
+#include "ObjectPack.hpp"
+#include "Logger.hpp"
+using namespace std;
+
+// Background repository maintenance: prune, incremental repack,
+// pack index refresh and prefetch of recent history.
+// Task status is kept in .minigit/maintenance/<task> (key=value lines).
+class Maintenance {
+public:
+    class MaintenanceError : public runtime_error {
+    public:
+        MaintenanceError(const string& msg) : runtime_error("[Maintenance] " + msg) {}
+    };
+
+    struct Options {
+        bool autoMode = false;                  // only run tasks whose thresholds are met
+        vector<string> tasks;                   // empty = all tasks
+        size_t looseThreshold = 100;            // loose objects before prune/repack
+        size_t maxPacks = 8;                    // consolidate packs beyond this count
+        double maxLoad = 0.75;                  // 1-minute load per core above which auto runs defer
+        long long pruneGraceSeconds = 14 * 24 * 3600;
+        long long repackMinAgeSeconds = 60;     // younger loose objects are left for the next run
+        size_t prefetchCommits = 50;            // recent commits to warm
+        bool fetchMissing = false;              // prefetch downloads blobs a blobless clone lacks
+        unsigned intervalSeconds = 3600;        // daemon wake-up interval
+    };
+
+    struct TaskStatus {
+        string name;
+        string status;          // ran, skipped, failed
+        string detail;
+        long long startedAt = 0;
+        long long durationMs = 0;
+        long long lastChecked = 0;  // last time the task was considered, run or not
+        string skipReason;          // why it was skipped then; empty if it ran
+    };
+
+    // Tasks in execution order: prune before repack so garbage is not packed
+    static const vector<string>& taskNames() {
+        static const vector<string> names = {"prune", "incremental-repack", "refresh-indexes", "prefetch"};
+        return names;
+    }
+
+    // Runs selected tasks once; returns immediately if another run holds the lock
+    static vector<TaskStatus> run(const Options& options) {
+        if (!filesystem::exists(".minigit")) throw MaintenanceError("Not a repository");
+        for (const auto& task : options.tasks) {
+            if (find(taskNames().begin(), taskNames().end(), task) == taskNames().end()) {
+                throw MaintenanceError("Unknown task: " + task);
+            }
+        }
+
+        vector<TaskStatus> statuses;
+        LockGuard lock;
+        bool locked = lock.locked;
+        double load = loadPerCore();
+        bool overloaded = options.autoMode && load > options.maxLoad;
+
+        for (const auto& name : taskNames()) {
+            if (!options.tasks.empty() &&
+                find(options.tasks.begin(), options.tasks.end(), name) == options.tasks.end()) {
+                continue;
+            }
+
+            long long checked = now();
+            TaskStatus status{name, "skipped", "", checked, 0, checked, ""};
+            if (!locked) {
+                status.detail = "another maintenance run holds the lock";
+            } else if (overloaded) {
+                ostringstream msg;
+                msg << fixed << setprecision(2) << "load " << load << " per core above " << options.maxLoad;
+                status.detail = msg.str();
+            } else if (options.autoMode && !isDue(name, options, status.detail)) {
+                // detail set by isDue
+            } else {
+                auto start = chrono::steady_clock::now();
+                try {
+                    status.detail = runTask(name, options);
+                    status.status = "ran";
+                } catch (const exception& e) {
+                    status.status = "failed";
+                    status.detail = e.what();
+                    Logger::error("maintenance " + name + ": " + e.what());
+                }
+                status.durationMs = chrono::duration_cast<chrono::milliseconds>(
+                    chrono::steady_clock::now() - start).count();
+            }
+            if (status.status == "skipped") status.skipReason = status.detail;
+
+            // Only the lock owner writes status; a skip keeps the last real run's result
+            if (locked) {
+                TaskStatus saved = status.status == "skipped" ? loadStatus(name) : status;
+                saved.lastChecked = status.lastChecked;
+                saved.skipReason = status.skipReason;
+                saveStatus(saved);
+            }
+            statuses.push_back(status);
+        }
+        return statuses;
+    }
+
+    // Machine-readable status of every task's last run plus object counts
+    static string statusJson() {
+        vector<TaskStatus> statuses;
+        for (const auto& name : taskNames()) statuses.push_back(loadStatus(name));
+        return statusJson(statuses);
+    }
+
+    // Same format for the given statuses, e.g. those returned by run()
+    static string statusJson(const vector<TaskStatus>& statuses) {
+        ostringstream out;
+        out << "{\n  \"looseObjects\": " << ObjectPack::listLoose(".minigit/objects").size()
+            << ",\n  \"packs\": " << ObjectPack::listPacks(".minigit/objects").size()
+            << ",\n  \"daemonPid\": " << runningDaemon()
+            << ",\n  \"tasks\": [";
+        bool first = true;
+        for (const auto& status : statuses) {
+            out << (first ? "\n" : ",\n")
+                << "    {\"name\": \"" << jsonEscape(status.name) << "\", "
+                << "\"status\": \"" << jsonEscape(status.status) << "\", "
+                << "\"detail\": \"" << jsonEscape(status.detail) << "\", "
+                << "\"startedAt\": " << status.startedAt << ", "
+                << "\"durationMs\": " << status.durationMs << ", "
+                << "\"lastChecked\": " << status.lastChecked << ", "
+                << "\"skipReason\": \"" << jsonEscape(status.skipReason) << "\"}";
+            first = false;
+        }
+        out << "\n  ]\n}\n";
+        return out.str();
+    }
+
+    // Runs auto maintenance every interval until SIGTERM/SIGINT (at lowered priority)
+    static void daemon(Options options) {
+        options.autoMode = true;
+        stopRequested() = 0;
+        signal(SIGTERM, [](int) { stopRequested() = 1; });
+        signal(SIGINT, [](int) { stopRequested() = 1; });
+        if (nice(10) == -1) Logger::error("maintenance daemon: could not lower priority");
+
+        Logger::log("Maintenance daemon started (pid " + to_string(getpid()) + ")");
+        while (!stopRequested()) {
+            try {
+                run(options);
+            } catch (const exception& e) {
+                Logger::error(string("maintenance daemon: ") + e.what());
+            }
+            for (unsigned waited = 0; waited < options.intervalSeconds && !stopRequested(); waited++) {
+                this_thread::sleep_for(chrono::seconds(1));
+            }
+        }
+        Logger::log("Maintenance daemon stopped");
+    }
+
+    // Forks a detached daemon and records its pid in .minigit/maintenance.pid
+    static pid_t start(const Options& options) {
+        if (pid_t running = runningDaemon()) {
+            throw MaintenanceError("Daemon already running (pid " + to_string(running) + ")");
+        }
+        pid_t pid = fork();
+        if (pid < 0) throw MaintenanceError("fork failed");
+        if (pid == 0) {
+            setsid();
+            daemon(options);
+            filesystem::remove(".minigit/maintenance.pid");
+            _exit(0);
+        }
+        ofstream(".minigit/maintenance.pid") << pid << "\n";
+        return pid;
+    }
+
+    static bool stop() {
+        pid_t pid = runningDaemon();
+        if (!pid) return false;
+        kill(pid, SIGTERM);
+        return true;
+    }
+
+    // Pid of the running daemon, 0 if none
+    static pid_t runningDaemon() {
+        ifstream file(".minigit/maintenance.pid");
+        pid_t pid = 0;
+        if (!(file >> pid) || pid <= 0 || kill(pid, 0) != 0) return 0;
+        return pid;
+    }
+
+private:
+    static volatile sig_atomic_t& stopRequested() {
+        static volatile sig_atomic_t flag = 0;
+        return flag;
+    }
+
+    static long long now() {
+        return chrono::duration_cast<chrono::seconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static double loadPerCore() {
+        double load[1] = {0};
+        if (getloadavg(load, 1) != 1) return 0;
+        unsigned cores = max(1u, thread::hardware_concurrency());
+        return load[0] / cores;
+    }
+
+    static filesystem::path lockPath() { return ".minigit/maintenance.lock"; }
+
+    // flock on the lock file, held through the open fd for the whole run; the
+    // kernel releases it when the owner exits, so there is no stale lock to take over
+    struct LockGuard {
+        int fd = acquireLock();
+        bool locked = fd >= 0;
+        ~LockGuard() {
+            if (fd >= 0) close(fd);
+        }
+    };
+
+    // The file is never removed: unlinking would let two runs lock different inodes
+    static int acquireLock() {
+        int fd = open(lockPath().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return -1;
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            close(fd);
+            return -1;
+        }
+        string owner = to_string(getpid()) + "\n"; // informational only
+        if (ftruncate(fd, 0) != 0 || write(fd, owner.data(), owner.size()) < 0) {
+            Logger::error("maintenance: could not record lock owner");
+        }
+        return fd;
+    }
+
+    // Threshold checks for --auto; sets reason when the task is not due
+    static bool isDue(const string& name, const Options& options, string& reason) {
+        size_t loose = ObjectPack::listLoose(".minigit/objects").size();
+        if (name == "prune" || name == "incremental-repack") {
+            size_t packs = ObjectPack::listPacks(".minigit/objects").size();
+            if (loose >= options.looseThreshold) return true;
+            if (name == "incremental-repack" && packs > options.maxPacks) return true;
+            reason = to_string(loose) + " loose objects below threshold " + to_string(options.looseThreshold);
+            return false;
+        }
+        if (name == "refresh-indexes") {
+            if (!stalePacks(false).empty()) return true;
+            reason = "all pack indexes up to date";
+            return false;
+        }
+        return true;
+    }
+
+    static string runTask(const string& name, const Options& options) {
+        if (name == "prune") return prune(options);
+        if (name == "incremental-repack") return repack(options);
+        if (name == "refresh-indexes") return refreshIndexes(!options.autoMode);
+        return prefetch(options);
+    }
+
+    // Commit hashes at the tips of refs/heads, refs/remotes and a detached HEAD
+    static vector<string> refTips() {
+        vector<string> tips;
+        error_code ec;
+        for (const auto& entry : filesystem::recursive_directory_iterator(".minigit/refs", ec)) {
+            if (!entry.is_regular_file()) continue;
+            ifstream file(entry.path());
+            string hash;
+            if (getline(file, hash) && !hash.empty()) tips.push_back(hash);
+        }
+        ifstream head(".minigit/HEAD");
+        string line;
+        if (getline(head, line) && !line.empty() && line.rfind("ref:", 0) != 0) tips.push_back(line);
+        return tips;
+    }
+
+    // Breadth-first walk over both parents; limit 0 walks the whole history
+    static vector<Commit> walkHistory(const vector<string>& tips, size_t limit,
+                                      vector<string>* hashes = nullptr) {
+        vector<Commit> commits;
+        unordered_set<string> visited;
+        deque<string> queue(tips.begin(), tips.end());
+        while (!queue.empty() && (limit == 0 || commits.size() < limit)) {
+            string hash = queue.front();
+            queue.pop_front();
+            if (hash.empty() || !visited.insert(hash).second) continue;
+
+            string data;
+            if (!ObjectPack::readObject(".minigit/objects", hash, data)) {
+                throw MaintenanceError("Missing commit " + hash);
+            }
+            istringstream in(data);
+            commits.push_back(Commit::parse(in));
+            if (hashes) hashes->push_back(hash);
+            queue.push_back(commits.back().getParent());
+            queue.push_back(commits.back().getMergeParent());
+        }
+        return commits;
+    }
+
+    // Commits and blobs reachable from refs; false when there are no refs at all
+    static bool reachableObjects(unordered_set<string>& reachable) {
+        auto tips = refTips();
+        if (tips.empty()) return false;
+
+        vector<string> commitHashes;
+        auto commits = walkHistory(tips, 0, &commitHashes);
+        reachable.insert(commitHashes.begin(), commitHashes.end());
+        for (const auto& commit : commits) {
+            for (const auto& [_, blob] : commit.getBlobs()) reachable.insert(blob);
+        }
+        return true;
+    }
+
+    static bool olderThan(const filesystem::path& path, long long seconds) {
+        error_code ec;
+        auto mtime = filesystem::last_write_time(path, ec);
+        return !ec && mtime <= filesystem::file_time_type::clock::now() - chrono::seconds(seconds);
+    }
+
+    // Deletes unreachable loose objects older than the grace period and
+    // temp files left behind by interrupted writers
+    static string prune(const Options& options) {
+        unordered_set<string> reachable;
+        if (!reachableObjects(reachable)) return "no refs, nothing considered unreachable";
+
+        size_t pruned = 0, recent = 0;
+        for (const auto& hash : ObjectPack::listLoose(".minigit/objects")) {
+            if (reachable.count(hash)) continue;
+            filesystem::path path = ".minigit/objects/" + hash;
+            error_code ec;
+            if (!olderThan(path, options.pruneGraceSeconds)) {
+                recent++;
+            } else if (filesystem::remove(path, ec)) {
+                pruned++;
+            }
+        }
+
+        for (const char* dir : {".minigit/objects", ".minigit/objects/pack"}) {
+            error_code ec;
+            for (const auto& entry : filesystem::directory_iterator(dir, ec)) {
+                string name = entry.path().filename().string();
+                bool temp = name.find(".tmp") != string::npos || name.rfind("incoming-", 0) == 0;
+                if (temp && entry.is_regular_file() && olderThan(entry.path(), 3600)) {
+                    filesystem::remove(entry.path(), ec);
+                }
+            }
+        }
+        return "pruned " + to_string(pruned) + " unreachable objects, kept " +
+               to_string(recent) + " within grace period";
+    }
+
+    // Packs reachable loose objects into a new pack; unreachable ones stay loose
+    // until prune expires them. Consolidates when too many packs exist.
+    static string repack(const Options& options) {
+        const filesystem::path objectsDir = ".minigit/objects";
+        filesystem::create_directories(objectsDir / "pack");
+
+        // Without refs nothing is garbage (prune does not run either)
+        unordered_set<string> reachable;
+        bool hasRefs = reachableObjects(reachable);
+
+        vector<string> loose;
+        size_t young = 0, unreachable = 0;
+        for (const auto& hash : ObjectPack::listLoose(objectsDir)) {
+            if (!olderThan(objectsDir / hash, options.repackMinAgeSeconds)) young++;
+            else if (hasRefs && !reachable.count(hash)) unreachable++;
+            else loose.push_back(hash);
+        }
+
+        string detail;
+        if (loose.empty()) {
+            detail = "no loose objects to pack";
+        } else {
+            writePack(loose);
+            // The pack is visible through its index; loose copies can go
+            for (const auto& hash : loose) filesystem::remove(objectsDir / hash);
+            detail = "packed " + to_string(loose.size()) + " loose objects";
+        }
+        detail += " (left " + to_string(young) + " recent, " + to_string(unreachable) + " unreachable)";
+
+        auto packs = ObjectPack::listPacks(objectsDir);
+        if (packs.size() > options.maxPacks) {
+            // Unreachable packed objects expire with the age of their pack
+            vector<string> hashes;
+            unordered_set<string> seen;
+            size_t dropped = 0;
+            for (const auto& pack : packs) {
+                bool expired = olderThan(pack, options.pruneGraceSeconds);
+                ifstream idx(ObjectPack::idxPath(pack));
+                string hash, offset, size;
+                while (idx >> hash >> offset >> size) {
+                    if (!seen.insert(hash).second) continue;
+                    if (hasRefs && expired && !reachable.count(hash)) dropped++;
+                    else hashes.push_back(hash);
+                }
+            }
+            if (!hashes.empty()) writePack(hashes);
+            for (const auto& pack : packs) {
+                filesystem::remove(ObjectPack::idxPath(pack));
+                filesystem::remove(pack);
+            }
+            detail += "; consolidated " + to_string(packs.size()) + " packs, dropped " +
+                      to_string(dropped) + " expired unreachable objects";
+        }
+        return detail;
+    }
+
+    // Writes under a temp name, then renames and indexes; a crash never leaves a
+    // truncated pack-*.pack behind
+    static filesystem::path writePack(const vector<string>& hashes) {
+        auto stamp = chrono::system_clock::now().time_since_epoch().count();
+        filesystem::path packPath = ".minigit/objects/pack/pack-" + to_string(stamp) + ".pack";
+        filesystem::path tmpPath = packPath.string() + ".tmp";
+
+        ObjectPack::write(".minigit/objects", hashes, tmpPath);
+        filesystem::rename(tmpPath, packPath);
+        ObjectPack::indexPack(packPath);
+        return packPath;
+    }
+
+    // Packs written by repack whose .idx is missing or older than the pack
+    static vector<filesystem::path> stalePacks(bool all) {
+        vector<filesystem::path> packs;
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(".minigit/objects/pack", ec)) {
+            const auto& path = entry.path();
+            if (path.extension() != ".pack" || path.filename().string().rfind("pack-", 0) != 0) continue;
+            auto idx = ObjectPack::idxPath(path);
+            if (all || !filesystem::exists(idx) ||
+                filesystem::last_write_time(idx) < filesystem::last_write_time(path)) {
+                packs.push_back(path);
+            }
+        }
+        return packs;
+    }
+
+    // Rebuilds pack indexes (all of them when run explicitly, stale ones under --auto)
+    // An unreadable pack without .idx was never visible to readers and is removed
+    static string refreshIndexes(bool all) {
+        size_t indexed = 0, objects = 0, removed = 0;
+        for (const auto& pack : stalePacks(all)) {
+            try {
+                objects += ObjectPack::indexPack(pack);
+                indexed++;
+            } catch (const exception&) {
+                if (filesystem::exists(ObjectPack::idxPath(pack))) throw;
+                filesystem::remove(pack);
+                removed++;
+            }
+        }
+        return "indexed " + to_string(indexed) + " packs (" + to_string(objects) + " objects), removed " +
+               to_string(removed) + " invalid packs";
+    }
+
+    // Warms the page cache with recent history's local objects. Blobs a blobless
+    // clone lacks are only downloaded with fetchMissing, so --auto keeps clones blobless.
+    static string prefetch(const Options& options) {
+        auto commits = walkHistory(refTips(), options.prefetchCommits);
+        vector<string> blobs;
+        unordered_set<string> seen;
+        for (const auto& commit : commits) {
+            for (const auto& [_, blob] : commit.getBlobs()) {
+                if (seen.insert(blob).second) blobs.push_back(blob);
+            }
+        }
+
+        size_t fetched = options.fetchMissing ? Blob::prefetch(blobs).size() : 0;
+        size_t local = 0, bytes = 0;
+        string data;
+        for (const auto& blob : blobs) {
+            if (!ObjectPack::readObject(".minigit/objects", blob, data)) continue;
+            local++;
+            bytes += data.size();
+        }
+        return "warmed " + to_string(commits.size()) + " commits, " + to_string(local) + " of " +
+               to_string(blobs.size()) + " blobs (" + to_string(bytes) + " bytes), fetched " +
+               to_string(fetched) + " missing blobs";
+    }
+
+    static filesystem::path statusPath(const string& name) {
+        return ".minigit/maintenance/" + name;
+    }
+
+    static void saveStatus(const TaskStatus& status) {
+        filesystem::create_directories(".minigit/maintenance");
+        filesystem::path tmp = statusPath(status.name).string() + ".tmp";
+        string detail = status.detail, skipReason = status.skipReason;
+        replace(detail.begin(), detail.end(), '\n', ' ');
+        replace(skipReason.begin(), skipReason.end(), '\n', ' ');
+        {
+            ofstream file(tmp);
+            file << "status=" << status.status << "\n"
+                 << "detail=" << detail << "\n"
+                 << "startedAt=" << status.startedAt << "\n"
+                 << "durationMs=" << status.durationMs << "\n"
+                 << "lastChecked=" << status.lastChecked << "\n"
+                 << "skipReason=" << skipReason << "\n";
+        }
+        filesystem::rename(tmp, statusPath(status.name));
+    }
+
+    static TaskStatus loadStatus(const string& name) {
+        TaskStatus status{name, "never", "", 0, 0, 0, ""};
+        ifstream file(statusPath(name));
+        string line;
+        while (getline(file, line)) {
+            size_t sep = line.find('=');
+            if (sep == string::npos) continue;
+            string key = line.substr(0, sep), value = line.substr(sep + 1);
+            if (key == "status") status.status = value;
+            else if (key == "detail") status.detail = value;
+            else if (key == "startedAt") status.startedAt = atoll(value.c_str());
+            else if (key == "durationMs") status.durationMs = atoll(value.c_str());
+            else if (key == "lastChecked") status.lastChecked = atoll(value.c_str());
+            else if (key == "skipReason") status.skipReason = value;
+        }
+        return status;
+    }
+
+    static string jsonEscape(const string& str) {
+        string escaped;
+        for (char c : str) {
+            switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        escaped += buf;
+                    } else {
+                        escaped += c;
+                    }
+            }
+        }
+        return escaped;
+    }
+};
@@ -0,0 +1,270 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cctype>
+#include <atomic>
+#include <unistd.h>
+using namespace std;
+
+// Pack files: transfer between object databases and packed local storage.
+// Format: "MINIGITPACK 1 <count>\n" followed by "<hash> <size>\n<bytes>" per object.
+// Packs under objects/pack are visible to readers once their .idx
+// ("<hash> <offset> <size>" lines) exists.
+class ObjectPack {
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct PackIndex {
+        filesystem::file_time_type mtime;
+        unordered_map<string, IndexEntry> entries;
+    };
+
+    // Thread-local cache of parsed .idx files, reloaded when the file changes.
+    // Every reload drops entries whose .idx is gone (packs removed by repack).
+    static const PackIndex& loadIndex(const filesystem::path& idxPath) {
+        thread_local unordered_map<string, PackIndex> cache;
+        static const PackIndex missing;
+        error_code ec;
+        auto mtime = filesystem::last_write_time(idxPath, ec);
+        if (auto it = cache.find(idxPath.string());
+            !ec && it != cache.end() && !it->second.entries.empty() && it->second.mtime == mtime) {
+            return it->second;
+        }
+
+        for (auto it = cache.begin(); it != cache.end();) {
+            it = filesystem::exists(it->first) ? next(it) : cache.erase(it);
+        }
+        if (ec) return missing;
+
+        auto& index = cache[idxPath.string()];
+        index.entries.clear();
+        index.mtime = mtime;
+        ifstream file(idxPath);
+        string hash;
+        IndexEntry entry;
+        while (file >> hash >> entry.offset >> entry.size) {
+            index.entries[hash] = entry;
+        }
+        return index;
+    }
+
+public:
+    // Object names are 40-digit hex hashes; anything else could escape the objects directory
+    static bool isObjectName(const string& name) {
+        return name.size() == 40 &&
+               all_of(name.begin(), name.end(), [](char c) { return isxdigit(static_cast<unsigned char>(c)); });
+    }
+
+    // Reads an object from loose storage or any indexed pack
+    static bool readObject(const filesystem::path& objectsDir, const string& hash, string& content) {
+        if (!isObjectName(hash)) return false;
+
+        ifstream loose(objectsDir / hash, ios::binary);
+        if (loose) {
+            content.assign(istreambuf_iterator<char>(loose), istreambuf_iterator<char>());
+            return true;
+        }
+
+        for (const auto& packPath : listPacks(objectsDir)) {
+            const auto& entries = loadIndex(idxPath(packPath)).entries;
+            auto it = entries.find(hash);
+            if (it == entries.end()) continue;
+
+            ifstream pack(packPath, ios::binary);
+            content.assign(it->second.size, '\0');
+            if (pack.seekg(it->second.offset) && pack.read(content.data(), it->second.size)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Writes a loose object through a temp file so readers never see partial content
+    static void writeLoose(const filesystem::path& objectsDir, const string& hash, const string& data) {
+        if (!isObjectName(hash)) throw runtime_error("Invalid object name: " + hash);
+        static atomic<unsigned> counter{0};
+        filesystem::path tmpPath = objectsDir / (hash + ".tmp-" + to_string(getpid()) + "-" +
+                                                 to_string(counter++));
+        {
+            ofstream object(tmpPath, ios::binary);
+            if (!object.write(data.data(), data.size())) {
+                throw runtime_error("Cannot write object: " + hash);
+            }
+        }
+        filesystem::rename(tmpPath, objectsDir / hash);
+    }
+
+    static bool hasObject(const filesystem::path& objectsDir, const string& hash) {
+        if (!isObjectName(hash)) return false;
+        if (filesystem::exists(objectsDir / hash)) return true;
+        for (const auto& packPath : listPacks(objectsDir)) {
+            if (loadIndex(idxPath(packPath)).entries.count(hash)) return true;
+        }
+        return false;
+    }
+
+    // Loose objects: regular files named by a 40-digit hex hash
+    static vector<string> listLoose(const filesystem::path& objectsDir) {
+        vector<string> hashes;
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(objectsDir, ec)) {
+            string name = entry.path().filename().string();
+            if (entry.is_regular_file() && isObjectName(name)) {
+                hashes.push_back(name);
+            }
+        }
+        return hashes;
+    }
+
+    // Indexed packs under objects/pack (a pack without .idx is not yet visible)
+    static vector<filesystem::path> listPacks(const filesystem::path& objectsDir) {
+        vector<filesystem::path> packs;
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(objectsDir / "pack", ec)) {
+            if (entry.path().extension() == ".pack" && filesystem::exists(idxPath(entry.path()))) {
+                packs.push_back(entry.path());
+            }
+        }
+        sort(packs.begin(), packs.end());
+        return packs;
+    }
+
+    static filesystem::path idxPath(const filesystem::path& packPath) {
+        return filesystem::path(packPath).replace_extension(".idx");
+    }
+
+    // Scans a pack and (re)writes its .idx atomically, returns the object count
+    static size_t indexPack(const filesystem::path& packPath) {
+        ifstream pack(packPath, ios::binary);
+        string magic, version;
+        size_t count = 0;
+        if (!(pack >> magic >> version >> count) || magic != "MINIGITPACK" || version != "1") {
+            throw runtime_error("Invalid pack: " + packPath.string());
+        }
+        pack.ignore(1);
+        uint64_t packSize = filesystem::file_size(packPath);
+
+        filesystem::path tmpPath = idxPath(packPath).string() + ".tmp";
+        try {
+            ofstream idx(tmpPath);
+            for (size_t i = 0; i < count; i++) {
+                string hash;
+                uint64_t size = 0;
+                if (!(pack >> hash >> size) || !isObjectName(hash)) {
+                    throw runtime_error("Truncated pack: " + packPath.string());
+                }
+                pack.ignore(1);
+                uint64_t offset = pack.tellg();
+                if (offset + size > packSize || !pack.seekg(offset + size)) {
+                    throw runtime_error("Truncated pack: " + packPath.string());
+                }
+                idx << hash << " " << offset << " " << size << "\n";
+            }
+        } catch (...) {
+            error_code ec;
+            filesystem::remove(tmpPath, ec);
+            throw;
+        }
+        filesystem::rename(tmpPath, idxPath(packPath));
+        return count;
+    }
+
+    // Writes the given objects from an objects directory into one pack file
+    static size_t write(const filesystem::path& objectsDir,
+                        const vector<string>& hashes,
+                        const filesystem::path& packPath) {
+        ofstream pack(packPath, ios::binary);
+        if (!pack) throw runtime_error("Cannot create pack: " + packPath.string());
+
+        pack << "MINIGITPACK 1 " << hashes.size() << "\n";
+        string data;
+        for (const auto& hash : hashes) {
+            if (!isObjectName(hash)) throw runtime_error("Invalid object name: " + hash);
+            if (!readObject(objectsDir, hash, data)) throw runtime_error("Object not found: " + hash);
+            pack << hash << " " << data.size() << "\n";
+            pack.write(data.data(), data.size());
+        }
+        return hashes.size();
+    }
+
+    // Unpacks every object in a pack into loose objects, returns the hashes written
+    static vector<string> unpack(const filesystem::path& packPath,
+                                 const filesystem::path& objectsDir) {
+        ifstream pack(packPath, ios::binary);
+        string magic, version;
+        size_t count = 0;
+        if (!(pack >> magic >> version >> count) || magic != "MINIGITPACK" || version != "1") {
+            throw runtime_error("Invalid pack: " + packPath.string());
+        }
+        pack.ignore(1);
+
+        vector<string> hashes;
+        hashes.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            string hash;
+            size_t size = 0;
+            if (!(pack >> hash >> size)) throw runtime_error("Truncated pack: " + packPath.string());
+            if (!isObjectName(hash)) throw runtime_error("Invalid object name in pack: " + hash);
+            pack.ignore(1);
+
+            string data(size, '\0');
+            if (!pack.read(data.data(), size)) throw runtime_error("Truncated pack: " + packPath.string());
+
+            writeLoose(objectsDir, hash, data);
+            hashes.push_back(hash);
+        }
+        return hashes;
+    }
+
+    // Sends objects from a remote repository into a local one through a temporary pack
+    static vector<string> transfer(const filesystem::path& remoteRoot,
+                                   const filesystem::path& localRoot,
+                                   const vector<string>& hashes) {
+        if (hashes.empty()) return {};
+        filesystem::path packDir = localRoot / ".minigit/objects/pack";
+        filesystem::create_directories(packDir);
+        // Unique per transfer: lazy loads and background prefetch may fetch concurrently
+        static atomic<unsigned> counter{0};
+        filesystem::path packPath = packDir / ("incoming-" + to_string(getpid()) + "-" +
+                                               to_string(counter++) + ".pack");
+
+        try {
+            write(remoteRoot / ".minigit/objects", hashes, packPath);
+            auto received = unpack(packPath, localRoot / ".minigit/objects");
+            filesystem::remove(packPath);
+            return received;
+        } catch (...) {
+            error_code ec;
+            filesystem::remove(packPath, ec);
+            throw;
+        }
+    }
+
+    // Reads .minigit/remote (key=value lines: url, filter)
+    static unordered_map<string, string> remoteConfig(const filesystem::path& root = ".") {
+        unordered_map<string, string> config;
+        ifstream file(root / ".minigit/remote");
+        string line;
+        while (getline(file, line)) {
+            size_t sep = line.find('=');
+            if (sep != string::npos) config[line.substr(0, sep)] = line.substr(sep + 1);
+        }
+        return config;
+    }
+
+    // Remote path that promises the blobs missing from a blobless clone, or ""
+    static string promisorRemote(const filesystem::path& root = ".") {
+        auto config = remoteConfig(root);
+        return config["filter"] == "blob:none" ? config["url"] : "";
+    }
+};
@@ -0,0 +1,183 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include "Commit.hpp"
+#include "ObjectPack.hpp"
+using namespace std;
+
+// Clone/fetch from another repository path on the same machine
+class Remote {
+public:
+    class RemoteError : public runtime_error {
+    public:
+        RemoteError(const string& msg) : runtime_error("[Remote] " + msg) {}
+    };
+
+    struct FetchResult {
+        size_t commits = 0;
+        size_t blobs = 0;
+        vector<string> updatedRefs;
+    };
+
+    // Clones a repository into dest; blobless clones fetch blobs on first use
+    static FetchResult clone(const string& url, const filesystem::path& dest, bool blobless = false) {
+        filesystem::path remoteRoot = filesystem::absolute(url);
+        if (!filesystem::exists(remoteRoot / ".minigit")) {
+            throw RemoteError("Not a repository: " + url);
+        }
+        if (filesystem::exists(dest / ".minigit")) {
+            throw RemoteError("Destination already initialized: " + dest.string());
+        }
+
+        // Remove a partial destination on failure so the clone can be retried
+        bool createdDest = !filesystem::exists(dest);
+        try {
+            filesystem::create_directories(dest / ".minigit/objects");
+            filesystem::create_directories(dest / ".minigit/refs/heads");
+            filesystem::create_directories(dest / ".minigit/logs");
+            {
+                ofstream config(dest / ".minigit/remote");
+                config << "url=" << remoteRoot.string() << "\n";
+                if (blobless) config << "filter=blob:none\n";
+            }
+
+            FetchResult result = fetch(dest);
+
+            // Local branches start at the remote-tracking refs
+            for (const auto& [branch, hash] : readRefs(dest, "refs/remotes/origin")) {
+                writeRef(dest, "refs/heads/" + branch, hash);
+            }
+            filesystem::copy_file(remoteRoot / ".minigit/HEAD", dest / ".minigit/HEAD",
+                                  filesystem::copy_options::overwrite_existing);
+            return result;
+        } catch (...) {
+            error_code ec;
+            filesystem::remove_all(createdDest ? dest : dest / ".minigit", ec);
+            throw;
+        }
+    }
+
+    // Fetches objects the local repository lacks and updates refs/remotes/origin
+    static FetchResult fetch(const filesystem::path& root = ".") {
+        if (!filesystem::exists(root / ".minigit")) throw RemoteError("Not a repository");
+        auto config = ObjectPack::remoteConfig(root);
+        if (config["url"].empty()) throw RemoteError("No remote configured");
+        filesystem::path remoteRoot = config["url"];
+        bool blobless = config["filter"] == "blob:none";
+
+        auto remoteRefs = readRefs(remoteRoot, "refs/heads");
+        vector<string> wants;
+        for (const auto& [_, hash] : remoteRefs) wants.push_back(hash);
+
+        // Haves: every commit reachable from local refs
+        unordered_set<string> haves;
+        for (const char* refDir : {"refs/heads", "refs/remotes/origin"}) {
+            for (const auto& [_, hash] : readRefs(root, refDir)) {
+                for (const auto& commit : walkCommits(root, {hash}, haves)) haves.insert(commit);
+            }
+        }
+
+        auto objects = negotiate(remoteRoot, wants, haves, blobless);
+
+        // Skip objects already present (e.g. blobs fetched lazily before)
+        vector<string> missing;
+        FetchResult result;
+        for (const auto& object : objects) {
+            if (ObjectPack::hasObject(root / ".minigit/objects", object.hash)) continue;
+            missing.push_back(object.hash);
+            (object.isCommit ? result.commits : result.blobs)++;
+        }
+        ObjectPack::transfer(remoteRoot, root, missing);
+
+        for (const auto& [branch, hash] : remoteRefs) {
+            string ref = "refs/remotes/origin/" + branch;
+            if (readRef(root, ref) != hash) {
+                writeRef(root, ref, hash);
+                result.updatedRefs.push_back(ref);
+            }
+        }
+        return result;
+    }
+
+    struct WantedObject {
+        string hash;
+        bool isCommit;
+    };
+
+    // Sender side: lists objects reachable from wants but not from haves
+    static vector<WantedObject> negotiate(const filesystem::path& remoteRoot,
+                                          const vector<string>& wants,
+                                          const unordered_set<string>& haves,
+                                          bool blobless) {
+        vector<WantedObject> objects;
+        unordered_set<string> seenBlobs;
+        for (const auto& hash : walkCommits(remoteRoot, wants, haves)) {
+            objects.push_back({hash, true});
+            if (blobless) continue;
+            Commit commit = readCommit(remoteRoot, hash);
+            for (const auto& [_, blob] : commit.getBlobs()) {
+                if (seenBlobs.insert(blob).second) objects.push_back({blob, false});
+            }
+        }
+        return objects;
+    }
+
+private:
+    // Commits reachable from tips, stopping at commits in stop
+    static vector<string> walkCommits(const filesystem::path& root,
+                                      const vector<string>& tips,
+                                      const unordered_set<string>& stop) {
+        vector<string> commits;
+        unordered_set<string> visited;
+        deque<string> queue(tips.begin(), tips.end());
+        while (!queue.empty()) {
+            string hash = queue.front();
+            queue.pop_front();
+            if (hash.empty() || stop.count(hash) || !visited.insert(hash).second) continue;
+            commits.push_back(hash);
+            Commit commit = readCommit(root, hash);
+            queue.push_back(commit.getParent());
+            queue.push_back(commit.getMergeParent());
+        }
+        return commits;
+    }
+
+    static Commit readCommit(const filesystem::path& root, const string& hash) {
+        string data;
+        if (!ObjectPack::readObject(root / ".minigit/objects", hash, data)) {
+            throw RemoteError("Commit not found: " + hash);
+        }
+        istringstream file(data);
+        return Commit::parse(file);
+    }
+
+    static unordered_map<string, string> readRefs(const filesystem::path& root, const string& refDir) {
+        unordered_map<string, string> refs;
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(root / ".minigit" / refDir, ec)) {
+            if (!entry.is_regular_file()) continue;
+            string hash = readRef(root, refDir + "/" + entry.path().filename().string());
+            if (!hash.empty()) refs[entry.path().filename().string()] = hash;
+        }
+        return refs;
+    }
+
+    static string readRef(const filesystem::path& root, const string& ref) {
+        ifstream file(root / ".minigit" / ref);
+        string hash;
+        getline(file, hash);
+        return hash;
+    }
+
+    static void writeRef(const filesystem::path& root, const string& ref, const string& hash) {
+        filesystem::path path = root / ".minigit" / ref;
+        filesystem::create_directories(path.parent_path());
+        ofstream file(path);
+        file << hash << "\n";
+    }
+};
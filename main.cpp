@@ -6,6 +6,8 @@
 #include "BranchMap.hpp"
 #include "StagingArea.hpp"
 #include "Diff.hpp"
+#include "Remote.hpp"
+#include "Maintenance.hpp"
 #include "Logger.hpp"
 
 using namespace std;
@@ -20,7 +22,15 @@ void printHelp() {
          << "  branch [name]      List/create branches\n"
          << "  checkout <branch>  Switch branches\n"
          << "  merge <branch>     Merge branch into current\n"
+         << "  clone <path> <dir> [--filter=blob:none]\n"
+         << "                     Clone repository (blobless: fetch blobs on use)\n"
+         << "  fetch [path]       Fetch missing objects from remote\n"
          << "  log                Show commit history\n"
+         << "  maintenance run [--auto] [--task=<name>] [--fetch-missing] [--json]\n"
+         << "                     Prune, repack, refresh indexes, prefetch\n"
+         << "                     (--fetch-missing downloads blobs a blobless clone lacks)\n"
+         << "  maintenance start|stop|status [--json]\n"
+         << "                     Control background maintenance daemon\n"
          << "  status             Show changed/staged files\n"
          << "  help               Show this help\n";
 }
@@ -99,6 +109,74 @@ int main(int argc, char* argv[]) {
                  << branchMap.getCurrentBranch() << "\n";
             cout << "New commit: " << newCommit.substr(0, 6) << "\n";
         }
+        else if (command == "clone") {
+            if (argc < 4) throw runtime_error("Usage: clone <path> <dir> [--filter=blob:none]");
+            bool blobless = argc > 4 && string(argv[4]) == "--filter=blob:none";
+            auto result = Remote::clone(argv[2], argv[3], blobless);
+            Logger::log("Cloned " + string(argv[2]) + " into " + argv[3]);
+            cout << "Cloned into '" << argv[3] << "': " << result.commits << " commits, "
+                 << result.blobs << " blobs" << (blobless ? " (blobless)" : "") << "\n";
+        }
+        else if (command == "fetch") {
+            if (!filesystem::exists(".minigit")) throw runtime_error("Not a repository");
+            if (argc > 2) {
+                string url = filesystem::absolute(argv[2]).lexically_normal().string();
+                string configured = ObjectPack::remoteConfig()["url"];
+                if (configured.empty()) {
+                    ofstream config(".minigit/remote");
+                    config << "url=" << url << "\n";
+                } else if (filesystem::path(configured).lexically_normal() != url) {
+                    throw runtime_error("Remote already configured as " + configured);
+                }
+            }
+            auto result = Remote::fetch();
+            for (const auto& ref : result.updatedRefs) cout << "Updated " << ref << "\n";
+            cout << "Fetched " << result.commits << " commits, " << result.blobs << " blobs\n";
+        }
+        else if (command == "maintenance") {
+            string action = argc > 2 ? argv[2] : "run";
+            Maintenance::Options options;
+            bool json = false;
+            for (int i = 3; i < argc; i++) {
+                string arg = argv[i];
+                if (arg == "--auto") options.autoMode = true;
+                else if (arg == "--json") json = true;
+                else if (arg == "--fetch-missing") options.fetchMissing = true;
+                else if (arg.rfind("--task=", 0) == 0) options.tasks.push_back(arg.substr(7));
+                else if (arg.rfind("--loose-threshold=", 0) == 0) options.looseThreshold = stoul(arg.substr(18));
+                else if (arg.rfind("--max-load=", 0) == 0) options.maxLoad = stod(arg.substr(11));
+                else if (arg.rfind("--grace=", 0) == 0) options.pruneGraceSeconds = stoll(arg.substr(8));
+                else if (arg.rfind("--interval=", 0) == 0) options.intervalSeconds = stoul(arg.substr(11));
+                else throw runtime_error("Unknown maintenance option: " + arg);
+            }
+
+            if (action == "run") {
+                auto statuses = Maintenance::run(options);
+                if (json) {
+                    cout << Maintenance::statusJson(statuses);
+                } else {
+                    for (const auto& status : statuses) {
+                        cout << status.name << ": " << status.status
+                             << (status.detail.empty() ? "" : " (" + status.detail + ")") << "\n";
+                    }
+                }
+            }
+            else if (action == "status") {
+                cout << Maintenance::statusJson();
+            }
+            else if (action == "start") {
+                cout << "Maintenance daemon started (pid " << Maintenance::start(options) << ")\n";
+            }
+            else if (action == "stop") {
+                cout << (Maintenance::stop() ? "Maintenance daemon stopped\n" : "No maintenance daemon running\n");
+            }
+            else if (action == "daemon") {
+                Maintenance::daemon(options);
+            }
+            else {
+                throw runtime_error("Unknown maintenance action: " + action);
+            }
+        }
         else if (command == "log") {
             repoManager.log();
         }
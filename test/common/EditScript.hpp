@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// Reference helpers for checking Diff::compare output independently of Diff
+namespace EditScript {
+
+// Splits on '\n' the same way Diff does (no trailing empty line)
+inline vector<string> splitLines(const string& str) {
+    vector<string> lines;
+    size_t start = 0, end = 0;
+    while ((end = str.find('\n', start)) != string::npos) {
+        lines.push_back(str.substr(start, end - start));
+        start = end + 1;
+    }
+    if (start < str.length()) {
+        lines.push_back(str.substr(start));
+    }
+    return lines;
+}
+
+// Replays a "+ "/"- "/"  " edit script over old lines, throws if it does not fit
+inline vector<string> apply(const vector<string>& oldLines, const vector<string>& edits) {
+    vector<string> result;
+    size_t pos = 0;
+    for (const auto& edit : edits) {
+        if (edit.size() < 2) throw runtime_error("malformed edit: '" + edit + "'");
+        string content = edit.substr(2);
+        string tag = edit.substr(0, 2);
+        if (tag == "+ ") {
+            result.push_back(content);
+        } else if (tag == "- " || tag == "  ") {
+            if (pos >= oldLines.size() || oldLines[pos] != content) {
+                throw runtime_error("edit does not match old line " + to_string(pos));
+            }
+            if (tag == "  ") result.push_back(content);
+            pos++;
+        } else {
+            throw runtime_error("unknown edit tag: '" + tag + "'");
+        }
+    }
+    if (pos != oldLines.size()) throw runtime_error("edit script leaves old lines unconsumed");
+    return result;
+}
+
+// Counts inserted and deleted lines in an edit script
+inline size_t editLength(const vector<string>& edits) {
+    return count_if(edits.begin(), edits.end(), [](const string& e) {
+        return e.compare(0, 2, "  ") != 0;
+    });
+}
+
+// LCS length with two rolling rows; shortest edit script is n + m - 2 * LCS
+inline size_t lcsLength(const vector<string>& a, const vector<string>& b) {
+    vector<size_t> prev(b.size() + 1, 0), cur(b.size() + 1, 0);
+    for (size_t i = 1; i <= a.size(); i++) {
+        for (size_t j = 1; j <= b.size(); j++) {
+            cur[j] = a[i-1] == b[j-1] ? prev[j-1] + 1 : max(prev[j], cur[j-1]);
+        }
+        swap(prev, cur);
+    }
+    return prev[b.size()];
+}
+
+inline size_t minimalEditLength(const vector<string>& a, const vector<string>& b) {
+    return a.size() + b.size() - 2 * lcsLength(a, b);
+}
+
+} // namespace EditScript
@@ -0,0 +1,66 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include "Blob.hpp"
+#include "Commit.hpp"
+
+using namespace std;
+
+// Scratch repositories and check helpers for tests that touch .minigit
+namespace TestRepo {
+
+inline int failures = 0;
+
+// Creates an empty repository (objects, refs/heads, HEAD on main) at root
+inline void init(const filesystem::path& root) {
+    filesystem::create_directories(root / ".minigit/objects");
+    filesystem::create_directories(root / ".minigit/refs/heads");
+    ofstream(root / ".minigit/HEAD") << "ref: refs/heads/main\n";
+}
+
+inline string readRef(const filesystem::path& root, const string& ref) {
+    ifstream file(root / ".minigit" / ref);
+    string hash;
+    getline(file, hash);
+    return hash;
+}
+
+inline void writeRef(const filesystem::path& root, const string& ref, const string& hash) {
+    ofstream(root / ".minigit" / ref) << hash << "\n";
+}
+
+// Two commits on main in the current repository: a.txt, then a.txt + b.txt
+struct History {
+    string blobOne = Blob::save("one\n");
+    string blobTwo = Blob::save("two\n");
+    Commit first{"first", "", {{"a.txt", blobOne}}};
+    Commit second{"second", first.getHash(), {{"a.txt", blobOne}, {"b.txt", blobTwo}}};
+
+    History() {
+        first.save();
+        second.save();
+        writeRef(".", "refs/heads/main", second.getHash());
+    }
+};
+
+// Prints the summary line and returns the process exit code
+inline int finish(const string& name) {
+    if (failures) {
+        cerr << failures << " " << name << " checks failed\n";
+        return 1;
+    }
+    cout << name << ": OK\n";
+    return 0;
+}
+
+} // namespace TestRepo
+
+#define EXPECT(cond)                                                    \
+    do {                                                                \
+        if (!(cond)) {                                                  \
+            cerr << "FAIL: " << #cond << " (line " << __LINE__ << ")\n"; \
+            TestRepo::failures++;                                       \
+        }                                                               \
+    } while (0)
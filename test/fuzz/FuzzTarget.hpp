@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// libFuzzer entry point, also driven by StandaloneFuzzMain.cpp
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// Aborts so libFuzzer (or the standalone driver) records the input as a crash
+#define FUZZ_CHECK(cond, msg)                                          \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            cerr << "FUZZ_CHECK failed: " << #cond << " - " << (msg)   \
+                 << " (" << __FILE__ << ":" << __LINE__ << ")\n";      \
+            abort();                                                   \
+        }                                                              \
+    } while (0)
+
+// Splits fuzz input into parts separated by '\0'; missing parts are empty
+inline vector<string> splitInput(const uint8_t* data, size_t size, size_t parts) {
+    vector<string> result(parts);
+    size_t part = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '\0' && part + 1 < parts) {
+            part++;
+        } else {
+            result[part] += static_cast<char>(data[i]);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,65 @@
+// Minimal libFuzzer-compatible driver for compilers without -fsanitize=fuzzer.
+// Replays corpus files/directories given on the command line, then runs
+// -runs=N random inputs (seeded by -seed=S, at most -max_len=L bytes).
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "FuzzTarget.hpp"
+
+namespace fs = std::filesystem;
+
+static void runOne(const string& input) {
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+static void runFile(const fs::path& path) {
+    ifstream file(path, ios::binary);
+    runOne({istreambuf_iterator<char>(file), istreambuf_iterator<char>()});
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long runs = 10000;
+    unsigned long seed = 1;
+    size_t maxLen = 512;
+    vector<string> corpus;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("-runs=", 0) == 0) runs = stoul(arg.substr(6));
+        else if (arg.rfind("-seed=", 0) == 0) seed = stoul(arg.substr(6));
+        else if (arg.rfind("-max_len=", 0) == 0) maxLen = stoul(arg.substr(9));
+        else if (arg[0] != '-') corpus.push_back(arg);
+    }
+
+    for (const auto& entry : corpus) {
+        if (fs::is_directory(entry)) {
+            for (const auto& file : fs::directory_iterator(entry)) runFile(file.path());
+        } else {
+            runFile(entry);
+        }
+    }
+
+    // Small alphabet so inputs hit separators and repeated lines often
+    static const string alphabet = "ab\n\n\n|\x01\0"s + "xyz0123";
+    mt19937_64 rng(seed);
+    uniform_int_distribution<size_t> lenDist(0, maxLen);
+    uniform_int_distribution<int> byteDist(0, 255);
+    uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+    for (unsigned long run = 0; run < runs; run++) {
+        string input(lenDist(rng), '\0');
+        bool rawBytes = run % 8 == 0;
+        for (auto& c : input) {
+            c = rawBytes ? static_cast<char>(byteDist(rng)) : alphabet[pick(rng)];
+        }
+        runOne(input);
+    }
+
+    cout << "Done " << runs << " runs (seed " << seed << ", "
+         << corpus.size() << " corpus paths)\n";
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include <sstream>
+#include <algorithm>
+#include "FuzzTarget.hpp"
+#include "Commit.hpp"
+
+// Input: raw commit object bytes as stored under .minigit/objects
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    istringstream in(string(reinterpret_cast<const char*>(data), size));
+    Commit parsed = Commit::parse(in);
+
+    // Serializing and re-parsing must preserve every parsed field
+    ostringstream out;
+    parsed.write(out);
+    istringstream again(out.str());
+    Commit reparsed = Commit::parse(again);
+
+    // A well-formed timestamp is kept as stored, not restamped with the current time
+    string input(reinterpret_cast<const char*>(data), size);
+    string meta = input.substr(0, input.find('\n'));
+    size_t sep1 = meta.find('|'), sep2 = meta.rfind('|');
+    if (sep1 != string::npos && sep2 > sep1) {
+        string field = meta.substr(sep1 + 1, sep2 - sep1 - 1);
+        if (!field.empty() && field.size() <= 12 &&
+            all_of(field.begin(), field.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            FUZZ_CHECK(parsed.getTimestamp() == stoll(field), "stored timestamp not kept");
+        }
+    }
+
+    FUZZ_CHECK(reparsed.getParent() == parsed.getParent(), "parent changed on round trip");
+    FUZZ_CHECK(reparsed.getMergeParent() == parsed.getMergeParent(), "merge parent changed on round trip");
+    FUZZ_CHECK(reparsed.getTimestamp() == parsed.getTimestamp(), "timestamp changed on round trip");
+    FUZZ_CHECK(reparsed.getHash() == parsed.getHash(), "hash changed on round trip");
+    FUZZ_CHECK(reparsed.getMessage() == parsed.getMessage(), "message changed on round trip");
+    FUZZ_CHECK(reparsed.getBlobs() == parsed.getBlobs(), "blobs changed on round trip");
+    return 0;
+}
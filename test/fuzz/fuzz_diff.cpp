@@ -0,0 +1,30 @@
+#include "FuzzTarget.hpp"
+#include "Diff.hpp"
+#include "../common/EditScript.hpp"
+
+// Input: old content '\0' new content
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size > 8192) return 0; // Diff is O(n*m) in lines
+    auto parts = splitInput(data, size, 2);
+    const string& oldContent = parts[0];
+    const string& newContent = parts[1];
+
+    auto edits = Diff::compare(oldContent, newContent);
+    auto oldLines = EditScript::splitLines(oldContent);
+    auto newLines = EditScript::splitLines(newContent);
+
+    vector<string> applied;
+    try {
+        applied = EditScript::apply(oldLines, edits);
+    } catch (const exception& e) {
+        FUZZ_CHECK(false, e.what());
+    }
+    FUZZ_CHECK(applied == newLines, "apply(old, edits) != new");
+    FUZZ_CHECK(EditScript::editLength(edits) == EditScript::minimalEditLength(oldLines, newLines),
+               "edit script is not minimal");
+
+    // Identical inputs must produce only KEEP lines
+    auto self = Diff::compare(oldContent, oldContent);
+    FUZZ_CHECK(EditScript::editLength(self) == 0, "diff of identical content has edits");
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "FuzzTarget.hpp"
+#include "BranchMap.hpp"
+
+// Builds a tree from "\x01"-separated entries; first byte picks one of four filenames
+static unordered_map<string, string> toTree(const string& part) {
+    unordered_map<string, string> tree;
+    size_t start = 0;
+    while (start < part.size()) {
+        size_t end = part.find('\x01', start);
+        if (end == string::npos) end = part.size();
+        if (end > start) {
+            string name = "f" + to_string(static_cast<unsigned char>(part[start]) % 4);
+            tree[name] = part.substr(start + 1, end - start - 1);
+        }
+        start = end + 1;
+    }
+    return tree;
+}
+
+// Input: ours '\0' theirs '\0' base
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size > 8192) return 0; // Diff is O(n*m) in lines
+    auto parts = splitInput(data, size, 3);
+    auto ours = toTree(parts[0]);
+    auto theirs = toTree(parts[1]);
+    auto base = toTree(parts[2]);
+
+    auto result = BranchMap::mergeContents(ours, theirs, base);
+    auto swapped = BranchMap::mergeContents(theirs, ours, base);
+
+    for (const auto& file : result.conflicts) {
+        FUZZ_CHECK(result.files.count(file), "conflicted file missing from result: " + file);
+    }
+    auto sorted = [](vector<string> v) { sort(v.begin(), v.end()); return v; };
+    FUZZ_CHECK(sorted(result.conflicts) == sorted(swapped.conflicts), "conflicts depend on side order");
+
+    for (const auto& [file, content] : result.files) {
+        FUZZ_CHECK(ours.count(file) || theirs.count(file), "result invents file: " + file);
+    }
+    return 0;
+}
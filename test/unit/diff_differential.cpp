@@ -0,0 +1,81 @@
+// Differential test for Diff::compare: replays every edit script against
+// the old content and checks it against an independent LCS reference.
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Diff.hpp"
+#include "../common/EditScript.hpp"
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(const string& oldContent, const string& newContent) {
+    auto edits = Diff::compare(oldContent, newContent);
+    auto oldLines = EditScript::splitLines(oldContent);
+    auto newLines = EditScript::splitLines(newContent);
+
+    string error;
+    try {
+        if (EditScript::apply(oldLines, edits) != newLines) {
+            error = "apply(old, edits) != new";
+        } else if (EditScript::editLength(edits) != EditScript::minimalEditLength(oldLines, newLines)) {
+            error = "edit length " + to_string(EditScript::editLength(edits)) +
+                    " is not minimal (" + to_string(EditScript::minimalEditLength(oldLines, newLines)) + ")";
+        }
+    } catch (const exception& e) {
+        error = e.what();
+    }
+
+    if (!error.empty() && failures++ < 10) {
+        cerr << "FAIL: " << error << "\n--- old ---\n" << oldContent
+             << "\n--- new ---\n" << newContent << "\n";
+    }
+}
+
+static string joinLines(const vector<string>& lines) {
+    string result;
+    for (const auto& line : lines) result += line + "\n";
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long seed = argc > 1 ? stoul(argv[1]) : 1;
+    int iterations = argc > 2 ? stoi(argv[2]) : 2000;
+
+    // Edge cases around empty content and trailing newlines
+    const vector<string> edges = {"", "\n", "\n\n", "a", "a\n", "a\nb", "a\nb\n", "b\na\n", "\na"};
+    for (const auto& oldContent : edges) {
+        for (const auto& newContent : edges) check(oldContent, newContent);
+    }
+
+    // Random files from a small vocabulary, mutated by line inserts/deletes/replaces
+    mt19937_64 rng(seed);
+    const vector<string> vocab = {"a", "b", "c", "", "{", "}", "return 0;"};
+    auto word = [&]() { return vocab[rng() % vocab.size()]; };
+
+    for (int it = 0; it < iterations; it++) {
+        vector<string> oldLines(rng() % 40);
+        for (auto& line : oldLines) line = word();
+
+        vector<string> newLines = oldLines;
+        int mutations = rng() % 8;
+        for (int m = 0; m < mutations; m++) {
+            size_t pos = newLines.empty() ? 0 : rng() % newLines.size();
+            switch (rng() % 3) {
+                case 0: newLines.insert(newLines.begin() + pos, word()); break;
+                case 1: if (!newLines.empty()) newLines.erase(newLines.begin() + pos); break;
+                case 2: if (!newLines.empty()) newLines[pos] = word(); break;
+            }
+        }
+        check(joinLines(oldLines), joinLines(newLines));
+    }
+
+    if (failures) {
+        cerr << failures << " failing diff cases (seed " << seed << ")\n";
+        return 1;
+    }
+    cout << "diff_differential: OK (seed " << seed << ")\n";
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Runs maintenance tasks on a scratch repository: prune of old unreachable
+// objects, incremental repack and consolidation, index refresh, auto
+// thresholds, local-only prefetch, locking and the machine-readable status.
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/file.h>
+#include "Maintenance.hpp"
+#include "../common/TestRepo.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static Maintenance::TaskStatus find(const vector<Maintenance::TaskStatus>& statuses, const string& name) {
+    for (const auto& status : statuses) {
+        if (status.name == name) return status;
+    }
+    return {name, "missing", "", 0, 0};
+}
+
+static void age(const fs::path& path) {
+    fs::last_write_time(path, fs::file_time_type::clock::now() - chrono::hours(24 * 30));
+}
+
+static bool isLoose(const string& hash) {
+    return fs::exists(".minigit/objects/" + hash);
+}
+
+static bool contains(const string& json, const string& text) {
+    return json.find(text) != string::npos;
+}
+
+// Holds the maintenance lock like a concurrent run would; -1 if it is taken
+static int holdLock() {
+    int fd = open(".minigit/maintenance.lock", O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main() {
+    fs::path work = fs::current_path() / "maintenance_work";
+    fs::remove_all(work);
+    TestRepo::init(work);
+    fs::current_path(work);
+
+    TestRepo::History history;
+    string oldGarbage = Blob::save("old garbage\n");
+    string newGarbage = Blob::save("new garbage\n");
+    age(".minigit/objects/" + oldGarbage);
+
+    Maintenance::Options options;
+    options.maxLoad = 1e9; // never defer on a busy test machine
+
+    // Objects younger than the minimum age may still be in flight and stay loose
+    options.tasks = {"incremental-repack"};
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(isLoose(history.blobOne));
+    EXPECT(ObjectPack::listPacks(".minigit/objects").empty());
+
+    // Explicit run executes every task; unreachable objects are never packed
+    options.tasks.clear();
+    options.repackMinAgeSeconds = 0;
+    auto statuses = Maintenance::run(options);
+    EXPECT(statuses.size() == Maintenance::taskNames().size());
+    EXPECT(find(statuses, "prune").status == "ran");
+    EXPECT(!isLoose(oldGarbage));
+    EXPECT(find(statuses, "incremental-repack").status == "ran");
+    EXPECT(!isLoose(history.blobOne));
+    EXPECT(ObjectPack::listPacks(".minigit/objects").size() == 1);
+    EXPECT(isLoose(newGarbage));
+    EXPECT(find(statuses, "prefetch").status == "ran");
+
+    // Objects stay readable from the pack
+    EXPECT(Blob::load(history.blobTwo) == "two\n");
+    EXPECT(Commit::load(history.second.getHash()).getParent() == history.first.getHash());
+
+    // Garbage inside the grace period is pruned once it ages past it
+    options.tasks = {"prune"};
+    Maintenance::run(options);
+    EXPECT(isLoose(newGarbage));
+    age(".minigit/objects/" + newGarbage);
+    Maintenance::run(options);
+    EXPECT(!isLoose(newGarbage));
+
+    // History reachable only through a merge's second parent survives prune
+    string sideBlob = Blob::save("side\n");
+    Commit side("side", history.first.getHash(), {{"c.txt", sideBlob}});
+    side.save();
+    Commit merge = Commit::createMergeCommit({{"a.txt", "one\n"}, {"c.txt", "side\n"}},
+                                             history.second.getHash(), side.getHash());
+    TestRepo::writeRef(".", "refs/heads/main", merge.getHash());
+    for (const auto& hash : ObjectPack::listLoose(".minigit/objects")) age(".minigit/objects/" + hash);
+    Maintenance::run(options);
+    EXPECT(isLoose(side.getHash()));
+    EXPECT(isLoose(sideBlob));
+
+    // A lost index is rebuilt by the auto refresh
+    auto pack = ObjectPack::listPacks(".minigit/objects").at(0);
+    fs::remove(ObjectPack::idxPath(pack));
+    EXPECT(!ObjectPack::hasObject(".minigit/objects", history.blobTwo));
+    options.autoMode = true;
+    options.tasks = {"refresh-indexes"};
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(Blob::load(history.blobTwo) == "two\n");
+
+    // A truncated pack without index (crashed writer) is removed, not retried forever
+    ofstream(".minigit/objects/pack/pack-1.pack") << "MINIGITPACK 1 3\n" << history.blobOne << " 100\nshort";
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(!fs::exists(".minigit/objects/pack/pack-1.pack"));
+
+    // A skip is reported as such by this run and saved next to the last real run
+    auto skipped = Maintenance::run(options);
+    EXPECT(skipped.at(0).status == "skipped");
+    EXPECT(contains(Maintenance::statusJson(skipped), "\"name\": \"refresh-indexes\", \"status\": \"skipped\""));
+    string saved = Maintenance::statusJson();
+    EXPECT(contains(saved, "\"name\": \"refresh-indexes\", \"status\": \"ran\""));
+    EXPECT(contains(saved, "\"skipReason\": \"all pack indexes up to date\""));
+
+    // Auto mode waits for the loose object threshold
+    options.tasks = {"incremental-repack"};
+    EXPECT(Maintenance::run(options).at(0).status == "skipped");
+    options.looseThreshold = 1;
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(!isLoose(side.getHash()));
+
+    // Consolidation drops unreachable packed objects whose pack has expired
+    string orphanBlob = Blob::save("orphan\n");
+    Commit orphan("orphan", "", {{"o.txt", orphanBlob}});
+    orphan.save();
+    TestRepo::writeRef(".", "refs/heads/tmp", orphan.getHash());
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    fs::remove(".minigit/refs/heads/tmp");
+    for (const auto& packPath : ObjectPack::listPacks(".minigit/objects")) age(packPath);
+    options.maxPacks = 1;
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(ObjectPack::listPacks(".minigit/objects").size() == 1);
+    EXPECT(!ObjectPack::hasObject(".minigit/objects", orphanBlob));
+    EXPECT(!ObjectPack::hasObject(".minigit/objects", orphan.getHash()));
+    EXPECT(Blob::load(history.blobOne) == "one\n");
+    EXPECT(Blob::load(sideBlob) == "side\n");
+
+    // Prefetch only reads local objects by default, so a blobless clone stays
+    // blobless under --auto; fetchMissing downloads what the clone lacks
+    fs::path upstream = work / "upstream";
+    TestRepo::init(upstream);
+    string lazyBlob = Blob::save("lazy\n");
+    fs::rename(".minigit/objects/" + lazyBlob, upstream / ".minigit/objects" / lazyBlob);
+    Commit lazy("lazy", merge.getHash(), {{"l.txt", lazyBlob}});
+    lazy.save();
+    TestRepo::writeRef(".", "refs/heads/main", lazy.getHash());
+    ofstream(".minigit/remote") << "url=" << upstream.string() << "\nfilter=blob:none\n";
+    options.tasks = {"prefetch"};
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(!ObjectPack::hasObject(".minigit/objects", lazyBlob));
+    options.fetchMissing = true;
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+    EXPECT(ObjectPack::hasObject(".minigit/objects", lazyBlob));
+
+    // A run holding the lock makes this one skip without saving status; a lock
+    // file left behind by an exited owner does not block
+    options.autoMode = false;
+    options.tasks = {"incremental-repack"};
+    int holder = holdLock();
+    EXPECT(holder >= 0);
+    string before = Maintenance::statusJson();
+    EXPECT(Maintenance::run(options).at(0).status == "skipped");
+    EXPECT(Maintenance::statusJson() == before);
+    close(holder);
+    ofstream(".minigit/maintenance.lock") << 999999999 << "\n";
+    EXPECT(Maintenance::run(options).at(0).status == "ran");
+
+    // The lock is released when a run throws (status directory cannot be created)
+    fs::rename(".minigit/maintenance", ".minigit/maintenance.saved");
+    ofstream(".minigit/maintenance") << "not a directory\n";
+    bool threw = false;
+    try {
+        Maintenance::run(options);
+    } catch (const exception&) {
+        threw = true;
+    }
+    EXPECT(threw);
+    holder = holdLock();
+    EXPECT(holder >= 0);
+    close(holder);
+    fs::remove(".minigit/maintenance");
+    fs::rename(".minigit/maintenance.saved", ".minigit/maintenance");
+
+    string json = Maintenance::statusJson();
+    EXPECT(json.find("\"name\": \"incremental-repack\", \"status\": \"ran\"") != string::npos);
+    EXPECT(json.find("\"looseObjects\": 0") != string::npos);
+
+    fs::current_path(work.parent_path());
+    fs::remove_all(work);
+    return TestRepo::finish("maintenance");
+}
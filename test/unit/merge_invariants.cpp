@@ -0,0 +1,162 @@
+// Randomized repository histories (commits, branches, merges) kept in
+// memory and merged with BranchMap::mergeContents, checking the
+// invariants every three-way merge must satisfy.
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BranchMap.hpp"
+
+using namespace std;
+
+using Tree = unordered_map<string, string>;
+
+struct Repo {
+    vector<Tree> trees;          // commit index -> file contents
+    vector<int> parents;         // first parent, -1 for root
+    unordered_map<string, int> branches;
+
+    int commit(const Tree& tree, int parent) {
+        trees.push_back(tree);
+        parents.push_back(parent);
+        return static_cast<int>(trees.size()) - 1;
+    }
+
+    // Same first-parent walk as Commit::findLCA
+    int lca(int a, int b) const {
+        unordered_set<int> visited;
+        for (int c = a; c != -1; c = parents[c]) visited.insert(c);
+        for (int c = b; c != -1; c = parents[c]) {
+            if (visited.count(c)) return c;
+        }
+        return -1;
+    }
+};
+
+static int failures = 0;
+
+static void fail(const string& msg) {
+    if (failures++ < 10) cerr << "FAIL: " << msg << "\n";
+}
+
+static const string* lookup(const Tree& tree, const string& file) {
+    auto it = tree.find(file);
+    return it == tree.end() ? nullptr : &it->second;
+}
+
+static bool sameEntry(const string* a, const string* b) {
+    return a == b || (a && b && *a == *b);
+}
+
+static void checkMerge(const Tree& ours, const Tree& theirs, const Tree& base) {
+    auto result = BranchMap::mergeContents(ours, theirs, base);
+    auto swapped = BranchMap::mergeContents(theirs, ours, base);
+
+    unordered_set<string> conflicts(result.conflicts.begin(), result.conflicts.end());
+    unordered_set<string> swappedConflicts(swapped.conflicts.begin(), swapped.conflicts.end());
+    if (conflicts != swappedConflicts) fail("conflict set depends on side order");
+
+    unordered_set<string> allFiles;
+    for (const Tree* tree : {&ours, &theirs, &base}) {
+        for (const auto& [file, _] : *tree) allFiles.insert(file);
+    }
+
+    for (const auto& file : allFiles) {
+        const string* o = lookup(ours, file);
+        const string* t = lookup(theirs, file);
+        const string* b = lookup(base, file);
+        const string* r = lookup(result.files, file);
+
+        // A side that did not touch the file must yield the other side's version
+        if (sameEntry(o, b) && !sameEntry(r, t)) fail("ours unchanged, result != theirs: " + file);
+        if (sameEntry(t, b) && !sameEntry(r, o)) fail("theirs unchanged, result != ours: " + file);
+        // Identical changes on both sides merge cleanly
+        if (sameEntry(o, t) && (!sameEntry(r, o) || conflicts.count(file))) {
+            fail("identical sides not merged cleanly: " + file);
+        }
+        if (conflicts.count(file) && (!r || sameEntry(o, b) || sameEntry(t, b))) {
+            fail("spurious conflict: " + file);
+        }
+        if (r && !o && !t) fail("result resurrects deleted file: " + file);
+        // Deleting a file the other side modified must not drop the change silently
+        if (b && (!o != !t) && !sameEntry(o ? o : t, b) && !conflicts.count(file)) {
+            fail("modify/delete not reported as conflict: " + file);
+        }
+    }
+
+    // Merging a tree with itself is a no-op
+    auto self = BranchMap::mergeContents(ours, ours, base);
+    if (self.files != ours || !self.conflicts.empty()) fail("merge(X, X) != X");
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long seed = argc > 1 ? stoul(argv[1]) : 1;
+    int histories = argc > 2 ? stoi(argv[2]) : 200;
+
+    mt19937_64 rng(seed);
+    const vector<string> names = {"README", "main.cpp", "a.txt", "b.txt", "dir/c.txt"};
+    const vector<string> vocab = {"alpha", "beta", "gamma", ""};
+    int merges = 0;
+
+    auto mutate = [&](Tree tree) {
+        int changes = 1 + rng() % 3;
+        for (int c = 0; c < changes; c++) {
+            const string& name = names[rng() % names.size()];
+            if (tree.count(name) && rng() % 4 == 0) {
+                tree.erase(name);
+                continue;
+            }
+            string& content = tree[name];
+            content += vocab[rng() % vocab.size()] + "\n";
+        }
+        return tree;
+    };
+
+    for (int h = 0; h < histories; h++) {
+        Repo repo;
+        repo.branches["main"] = repo.commit(mutate({}), -1);
+
+        for (int step = 0; step < 30; step++) {
+            vector<string> branchNames;
+            for (const auto& [name, _] : repo.branches) branchNames.push_back(name);
+            sort(branchNames.begin(), branchNames.end());
+            const string& branch = branchNames[rng() % branchNames.size()];
+            int head = repo.branches[branch];
+
+            switch (rng() % 4) {
+                case 0: // Fork a branch from a random ancestor of this head
+                {
+                    int from = head;
+                    for (int back = rng() % 4; back > 0 && repo.parents[from] != -1; back--) {
+                        from = repo.parents[from];
+                    }
+                    repo.branches["b" + to_string(step)] = from;
+                    break;
+                }
+                case 1: // Merge another branch into this one
+                {
+                    const string& other = branchNames[rng() % branchNames.size()];
+                    int theirs = repo.branches[other];
+                    int base = repo.lca(head, theirs);
+                    const Tree empty;
+                    const Tree& baseTree = base == -1 ? empty : repo.trees[base];
+                    checkMerge(repo.trees[head], repo.trees[theirs], baseTree);
+                    auto result = BranchMap::mergeContents(repo.trees[head], repo.trees[theirs], baseTree);
+                    repo.branches[branch] = repo.commit(result.files, head);
+                    merges++;
+                    break;
+                }
+                default: // Commit local changes
+                    repo.branches[branch] = repo.commit(mutate(repo.trees[head]), head);
+                    break;
+            }
+        }
+    }
+
+    if (failures) {
+        cerr << failures << " merge invariant violations (seed " << seed << ")\n";
+        return 1;
+    }
+    cout << "merge_invariants: OK (" << merges << " merges, seed " << seed << ")\n";
+    return 0;
+}
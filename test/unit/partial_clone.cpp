@@ -0,0 +1,98 @@
+// Clones a repository from another directory (full and blobless), checks
+// that only missing objects are transferred and that blobs are fetched
+// lazily on first Blob::load.
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include "Remote.hpp"
+#include "Blob.hpp"
+#include "../common/TestRepo.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+using TestRepo::readRef;
+using TestRepo::writeRef;
+
+int main() {
+    fs::path work = fs::current_path() / "partial_clone_work";
+    fs::remove_all(work);
+    fs::path remote = work / "remote";
+    TestRepo::init(remote);
+
+    // Remote history: two commits, two blobs
+    fs::current_path(remote);
+    TestRepo::History history;
+    const string& blobOne = history.blobOne;
+    const string& blobTwo = history.blobTwo;
+
+    fs::current_path(work);
+
+    // Blobless clone gets history and refs but no blobs
+    auto blobless = Remote::clone("remote", "blobless", true);
+    EXPECT(blobless.commits == 2);
+    EXPECT(blobless.blobs == 0);
+    EXPECT(readRef("blobless", "refs/heads/main") == history.second.getHash());
+    EXPECT(fs::exists("blobless/.minigit/objects/" + history.first.getHash()));
+    EXPECT(!fs::exists("blobless/.minigit/objects/" + blobOne));
+
+    // Blobs arrive on first load and stay in the local object store
+    fs::current_path(work / "blobless");
+    EXPECT(Blob::load(blobTwo) == "two\n");
+    EXPECT(fs::exists(".minigit/objects/" + blobTwo));
+    auto fetched = Blob::prefetch({blobOne, blobOne, blobTwo});
+    EXPECT(fetched.size() == 1 && fetched[0] == blobOne);
+    EXPECT(Blob::prefetch({blobOne, blobTwo}).empty());
+    EXPECT(!fs::exists(".minigit/objects/pack") || fs::is_empty(".minigit/objects/pack"));
+    fs::current_path(work);
+
+    // Full clone transfers each blob once
+    auto full = Remote::clone("remote", "full");
+    EXPECT(full.commits == 2);
+    EXPECT(full.blobs == 2);
+
+    // Incremental fetch negotiates only the new commit and blob
+    fs::current_path(remote);
+    string blobThree = Blob::save("three\n");
+    Commit third("third", history.second.getHash(), {{"a.txt", blobOne}, {"b.txt", blobThree}});
+    third.save();
+    writeRef(remote, "refs/heads/main", third.getHash());
+    fs::current_path(work);
+
+    auto update = Remote::fetch("full");
+    EXPECT(update.commits == 1);
+    EXPECT(update.blobs == 1);
+    EXPECT(readRef("full", "refs/remotes/origin/main") == third.getHash());
+    EXPECT(Remote::fetch("full").commits == 0);
+
+    // Fetching outside a repository fails before touching the remote config
+    fs::create_directories("plain");
+    bool notRepo = false;
+    try {
+        Remote::fetch("plain");
+    } catch (const Remote::RemoteError& e) {
+        notRepo = string(e.what()).find("Not a repository") != string::npos;
+    }
+    EXPECT(notRepo);
+
+    // A remote commit naming an object outside objects/ is rejected, and the
+    // failed clone leaves no partial destination behind
+    fs::current_path(remote);
+    Commit hostile("hostile", third.getHash(), {{"x", "../../../escape"}});
+    hostile.save();
+    writeRef(remote, "refs/heads/main", hostile.getHash());
+    fs::current_path(work);
+
+    bool rejected = false;
+    try {
+        Remote::clone("remote", "hostile");
+    } catch (const exception&) {
+        rejected = true;
+    }
+    EXPECT(rejected);
+    EXPECT(!fs::exists("hostile"));
+    EXPECT(!fs::exists(work / "escape"));
+
+    fs::current_path(work.parent_path());
+    fs::remove_all(work);
+    return TestRepo::finish("partial_clone");
+}